@@ -0,0 +1,38 @@
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include "Exporter.h"
+
+// Headless entry point, renders a rectangle of the world straight to an image file.
+// Usage: PIWGexport seed row column rows columns path [threads]
+int main(int argc, char* argv[]){
+    const std::string usage = std::string("Usage: ") + argv[0] + " seed row column rows columns path.(pgm|png) [threads]\n";
+
+    if (argc < 7){
+        std::cerr << usage;
+        return 1;
+    }
+
+    try {
+        Exporter exporter(std::stoi(argv[1]));
+
+        if (argc > 7){
+            exporter.threadCount() = std::max(std::stoi(argv[7]), 1);
+        }
+
+        Location worldLocation = Location(std::stoi(argv[2]), std::stoi(argv[3]));
+        Location size = Location(std::stoi(argv[4]), std::stoi(argv[5]));
+
+        if (!exporter.exportArea(worldLocation, size, argv[6])){
+            std::cerr << "Failed to export to " << argv[6] << "\n";
+            return 1;
+        }
+    } catch (const std::exception& exception){
+        // Malformed or out of range arguments.
+        std::cerr << usage;
+        return 1;
+    }
+
+    return 0;
+}
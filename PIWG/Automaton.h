@@ -0,0 +1,23 @@
+#pragma once
+#include "Tile.h"
+
+// The cellular automata rules shared by the world and the exporter, so
+// both always smooth random noise into the same kind of landscape.
+class Automaton{
+    public:
+        // How many times the algorithm should loop, higher values lead
+        // to a longer loading time but a smoother world.
+        static const int cycles{7};
+
+        // Determines what type a tile becomes after one cycle, based on
+        // how many of the eight tiles surrounding it are walls.
+        static TileTypes nextType(TileTypes type, int wallCount){
+            if (type == TILE_GROUND && wallCount >= 5){
+                return TILE_WALL;
+            } else if (type == TILE_WALL && wallCount < 4){
+                return TILE_GROUND;
+            }
+
+            return type;
+        }
+};
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include "Automaton.h"
+#include "Exporter.h"
+
+Exporter::Exporter(int seed, int regionSize, int threadCount) : _seed(seed), _regionSize(regionSize), _threadCount(std::max(threadCount, 1)), _tileSize(Location(4, 8)), _adler(1){
+    return;
+}
+
+bool Exporter::exportArea(Location worldLocation, Location size, std::string path){
+    if (size.row() <= 0 || size.column() <= 0 || _regionSize <= 0){
+        return false;
+    }
+
+    std::ofstream outFile;
+    outFile.open(path, std::ostream::binary | std::ostream::trunc);
+
+    if (!outFile.is_open()){
+        return false;
+    }
+
+    ImageFormats format = formatOf(path);
+    writeHeader(outFile, format, size);
+
+    // Strips and tiles are aligned to the region grid, so the rectangle is
+    // first widened to the regions which contain its top left and bottom right tiles.
+    Location firstRegion = Location(floor(double(worldLocation.row()) / double(_regionSize)), floor(double(worldLocation.column()) / double(_regionSize)));
+    Location lastRegion = Location(floor(double(worldLocation.row() + size.row() - 1) / double(_regionSize)), floor(double(worldLocation.column() + size.column() - 1) / double(_regionSize)));
+    Location tileSize = Location(std::max(_tileSize.row(), 1), std::max(_tileSize.column(), 1));
+    int tileCount = (lastRegion.column() - firstRegion.column()) / tileSize.column() + 1;
+
+    // Only a single strip of pixels is ever held in memory.
+    std::vector<uint8_t> pixels;
+
+    for (int stripRegion = firstRegion.row(); stripRegion <= lastRegion.row(); stripRegion += tileSize.row()){
+        int top = std::max(stripRegion * _regionSize, worldLocation.row());
+        int bottom = std::min((stripRegion + tileSize.row()) * _regionSize, worldLocation.row() + size.row());
+        int stripRows = bottom - top;
+
+        pixels.assign(size_t(stripRows) * size_t(size.column()), 0);
+        std::atomic<int> nextTile{0};
+
+        // Each worker claims tiles of the strip until none are left, smoothing them independently.
+        auto worker = [&](){
+            std::vector<TileTypes> tiles;
+
+            for (int t = nextTile++; t < tileCount; t = nextTile++){
+                int tileRegion = firstRegion.column() + t * tileSize.column();
+                int left = std::max(tileRegion * _regionSize, worldLocation.column());
+                int right = std::min((tileRegion + tileSize.column()) * _regionSize, worldLocation.column() + size.column());
+                int tileColumns = right - left;
+
+                generateArea(Location(top, left), Location(stripRows, tileColumns), tiles);
+
+                // Walls are drawn dark and ground is drawn light.
+                for (int i = 0; i < stripRows; i++){
+                    uint8_t* row = &pixels[size_t(i) * size_t(size.column()) + size_t(left - worldLocation.column())];
+
+                    for (int j = 0; j < tileColumns; j++){
+                        row[j] = tiles[size_t(i) * size_t(tileColumns) + size_t(j)] == TILE_WALL ? 0 : 255;
+                    }
+                }
+            }
+        };
+
+        int workerCount = std::min(_threadCount, tileCount);
+        std::vector<std::thread> workers;
+
+        for (int w = 1; w < workerCount; w++){
+            workers.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto & thread : workers){
+            thread.join();
+        }
+
+        writeRows(outFile, format, pixels, size.column());
+    }
+
+    writeFooter(outFile, format);
+    outFile.close();
+    return !outFile.fail();
+}
+
+void Exporter::generateArea(Location worldLocation, Location size, std::vector<TileTypes>& tiles){
+    // A tile can only be influenced by tiles within one step per cycle, so generating an apron
+    // of that width around the area makes the result independent of where the area was cut.
+    const int apron{Automaton::cycles};
+    const int rows = size.row() + apron * 2;
+    const int columns = size.column() + apron * 2;
+
+    std::vector<TileTypes> current(size_t(rows) * size_t(columns));
+    std::vector<TileTypes> next;
+
+    // Populates the area and its apron with random noise.
+    for (int i = 0; i < rows; i++){
+        for (int j = 0; j < columns; j++){
+            current[size_t(i) * size_t(columns) + size_t(j)] = noiseAt(worldLocation + Location(i - apron, j - apron));
+        }
+    }
+
+    next = current;
+
+    // Cellular automata algorithm, using the same rules as World::smoothRegions. Each cycle
+    // shrinks the window it updates by one tile, so it never reads past the generated apron.
+    for (int c = 0; c < Automaton::cycles; c++){
+        for (int i = c + 1; i < rows - c - 1; i++){
+            const TileTypes* above = &current[size_t(i - 1) * size_t(columns)];
+            const TileTypes* middle = &current[size_t(i) * size_t(columns)];
+            const TileTypes* below = &current[size_t(i + 1) * size_t(columns)];
+            TileTypes* out = &next[size_t(i) * size_t(columns)];
+
+            for (int j = c + 1; j < columns - c - 1; j++){
+                int wallCount = (above[j - 1] == TILE_WALL) + (above[j] == TILE_WALL) + (above[j + 1] == TILE_WALL)
+                              + (middle[j - 1] == TILE_WALL) + (middle[j + 1] == TILE_WALL)
+                              + (below[j - 1] == TILE_WALL) + (below[j] == TILE_WALL) + (below[j + 1] == TILE_WALL);
+
+                // Each tile switches type based on its surroundings.
+                out[j] = Automaton::nextType(middle[j], wallCount);
+            }
+        }
+
+        current.swap(next);
+    }
+
+    // Crops the apron off of the smoothed area.
+    tiles.resize(size_t(size.row()) * size_t(size.column()));
+
+    for (int i = 0; i < size.row(); i++){
+        std::copy_n(&current[size_t(i + apron) * size_t(columns) + size_t(apron)], size.column(), &tiles[size_t(i) * size_t(size.column())]);
+    }
+
+    return;
+}
+
+ImageFormats Exporter::formatOf(std::string path){
+    std::string extension = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c){return std::tolower(c);});
+    return extension == ".png" ? IMAGE_PNG : IMAGE_PGM;
+}
+
+TileTypes Exporter::noiseAt(Location worldLocation){
+    // Hashes the seed and location together (splitmix64 finalizer per component) so that
+    // every tile's noise can be computed on any thread without sharing a random generator.
+    uint64_t hash = _seed;
+    for (int value : {worldLocation.row(), worldLocation.column()}){
+        hash ^= uint32_t(value);
+        hash += 0x9E3779B97F4A7C15ull;
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        hash = hash ^ (hash >> 31);
+    }
+    return hash % 2 == 0 ? TILE_WALL : TILE_GROUND;
+}
+
+void Exporter::writeHeader(std::ofstream& outFile, ImageFormats format, Location size){
+    if (format == IMAGE_PGM){
+        // Binary greyscale PGM, format appears as "P5 width height maxValue" followed by raw bytes.
+        outFile << "P5\n" << size.column() << " " << size.row() << "\n255\n";
+        return;
+    }
+
+    const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    outFile.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    // 8-bit greyscale, no interlacing.
+    std::vector<uint8_t> header;
+    for (int value : {size.column(), size.row()}){
+        for (int shift = 24; shift >= 0; shift -= 8){
+            header.push_back(uint8_t(uint32_t(value) >> shift));
+        }
+    }
+    header.insert(header.end(), {8, 0, 0, 0, 0});
+    writeChunk(outFile, "IHDR", header);
+
+    // The pixel data is a single zlib stream spread over many IDAT chunks, starting with its header.
+    _adler = 1;
+    writeChunk(outFile, "IDAT", {0x78, 0x01});
+    return;
+}
+
+void Exporter::writeRows(std::ofstream& outFile, ImageFormats format, const std::vector<uint8_t>& pixels, int width){
+    if (format == IMAGE_PGM){
+        outFile.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+        return;
+    }
+
+    // Every PNG row is prefixed with its filter type, which is always none.
+    std::vector<uint8_t> raw;
+    raw.reserve(pixels.size() + pixels.size() / size_t(width));
+
+    for (size_t i = 0; i < pixels.size(); i += size_t(width)){
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels.begin() + i, pixels.begin() + i + size_t(width));
+    }
+
+    // Updates the running adler32 checksum of the uncompressed stream.
+    uint32_t a = _adler & 0xFFFF, b = _adler >> 16;
+    for (uint8_t byte : raw){
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    _adler = (b << 16) | a;
+
+    // Wraps the rows in stored (uncompressed) deflate blocks, none of which are final.
+    std::vector<uint8_t> data;
+
+    for (size_t offset = 0; offset < raw.size(); offset += 65535){
+        uint16_t length = uint16_t(std::min(raw.size() - offset, size_t(65535)));
+        data.insert(data.end(), {0x00, uint8_t(length), uint8_t(length >> 8), uint8_t(~length), uint8_t(uint16_t(~length) >> 8)});
+        data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + length);
+    }
+
+    writeChunk(outFile, "IDAT", data);
+    return;
+}
+
+void Exporter::writeFooter(std::ofstream& outFile, ImageFormats format){
+    if (format == IMAGE_PGM){
+        return;
+    }
+
+    // Closes the zlib stream with an empty final block and the checksum.
+    writeChunk(outFile, "IDAT", {0x01, 0x00, 0x00, 0xFF, 0xFF, uint8_t(_adler >> 24), uint8_t(_adler >> 16), uint8_t(_adler >> 8), uint8_t(_adler)});
+    writeChunk(outFile, "IEND", {});
+    return;
+}
+
+void Exporter::writeChunk(std::ofstream& outFile, const char* type, const std::vector<uint8_t>& data){
+    static uint32_t table[256];
+    static bool tableReady{false};
+
+    if (!tableReady){
+        for (uint32_t n = 0; n < 256; n++){
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++){
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        tableReady = true;
+    }
+
+    // Chunk format is length, type, data and then a crc32 of the type and data.
+    uint32_t length = data.size();
+    const uint8_t lengthBytes[] = {uint8_t(length >> 24), uint8_t(length >> 16), uint8_t(length >> 8), uint8_t(length)};
+    outFile.write(reinterpret_cast<const char*>(lengthBytes), 4);
+    outFile.write(type, 4);
+    outFile.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (int i = 0; i < 4; i++){
+        crc = table[(crc ^ uint8_t(type[i])) & 0xFF] ^ (crc >> 8);
+    }
+    for (uint8_t byte : data){
+        crc = table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    }
+    crc ^= 0xFFFFFFFFu;
+
+    const uint8_t crcBytes[] = {uint8_t(crc >> 24), uint8_t(crc >> 16), uint8_t(crc >> 8), uint8_t(crc)};
+    outFile.write(reinterpret_cast<const char*>(crcBytes), 4);
+    return;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <ctime>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Tile.h"
+#include "Location.h"
+
+// Image formats the exporter is able to write, chosen by the extension of the output path.
+typedef enum{IMAGE_PGM, IMAGE_PNG} ImageFormats;
+
+// Headless renderer which generates a world-space rectangle and writes it to an image file.
+// The rectangle is processed in strips of regions, and each strip is split into tiles of regions
+// which are generated and smoothed in parallel, so memory stays bounded by the width of a single strip.
+// Noise is hashed from the seed and each tile's location instead of drawn from rand, so the images
+// are deterministic but don't match what the world class generates for the same seed. The region
+// size only decides how the rectangle is partitioned and has no effect on the image itself.
+class Exporter{
+    public:
+        Exporter(int seed = time(NULL), int regionSize = 15, int threadCount = std::thread::hardware_concurrency());
+        ~Exporter(){}
+
+        // Generates every tile within the rectangle starting at a world location
+        // with the given size (rows, columns) and writes it to the file at path.
+        // Returns false if the rectangle is empty or the file could not be written.
+        bool exportArea(Location worldLocation, Location size, std::string path);
+
+        // Generates and smooths a rectangle of tiles into an output buffer, each row is size.column() long.
+        // Deterministic for a given seed and independent of how the rectangle is partitioned.
+        void generateArea(Location worldLocation, Location size, std::vector<TileTypes>& tiles);
+
+        // Determines the image format from the extension of a path.
+        static ImageFormats formatOf(std::string path);
+
+        int& regionSize(){return _regionSize;}
+        const int regionSize() const{return _regionSize;}
+        int& threadCount(){return _threadCount;}
+        const int threadCount() const{return _threadCount;}
+        Location& tileSize(){return _tileSize;}
+        const Location& tileSize() const{return _tileSize;}
+    private:
+        // The random noise a tile starts with before being smoothed.
+        TileTypes noiseAt(Location worldLocation);
+
+        // Functions which stream an image to a file a strip of rows at a time.
+        void writeHeader(std::ofstream& outFile, ImageFormats format, Location size);
+        void writeRows(std::ofstream& outFile, ImageFormats format, const std::vector<uint8_t>& pixels, int width);
+        void writeFooter(std::ofstream& outFile, ImageFormats format);
+        void writeChunk(std::ofstream& outFile, const char* type, const std::vector<uint8_t>& data);
+
+        uint32_t _seed;
+        int _regionSize;
+        int _threadCount;
+        Location _tileSize; // How many regions (rows, columns) each parallel job generates.
+        uint32_t _adler; // Running checksum of the PNG pixel stream.
+};
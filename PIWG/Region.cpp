@@ -1,7 +1,8 @@
 #include "Region.h"
 
 // Upon a region being created, it populates itself with a random noise of tiles.
-Region::Region(int size) : _isComplete(false){
+// A generated region has never been saved, so it starts out dirty.
+Region::Region(int size) : _isComplete(false), _isDirty(true), _size(size), _wallsValid(false){
     for (int i = 0; i < size; i++){
         for (int j = 0; j < size; j++){
             createTile(Location(i, j), rand() % 2 == 0 ? Tile(TILE_WALL) : Tile(TILE_GROUND));
@@ -11,12 +12,13 @@ Region::Region(int size) : _isComplete(false){
     return;
 }
 
-Region::Region(std::map<Location, Tile> tiles){
+// A loaded region was already smoothed before being saved and matches its file.
+Region::Region(std::map<Location, Tile> tiles, int size) : _isComplete(true), _isDirty(false), _size(size), _wallsValid(false){
     _tiles = tiles;
     return;
 }
 
-Tile* Region::tileAt(Location localLocation){
+const Tile* Region::tileAt(Location localLocation){
     if (_tiles.find(localLocation) != _tiles.end()){
         return &_tiles.find(localLocation)->second;
     }
@@ -24,14 +26,31 @@ Tile* Region::tileAt(Location localLocation){
     return nullptr;
 }
 
-Tile* Region::createTile(Location localLocation, Tile tile){
+const Tile* Region::createTile(Location localLocation, Tile tile){
     _tiles.emplace(localLocation, tile);
+    _isDirty = true;
+    _wallsValid = false;
     return tileAt(localLocation);
 }
 
+void Region::setTileType(Location localLocation, TileTypes type){
+    auto tile = _tiles.find(localLocation);
+
+    // Only an actual change in type modifies the region.
+    if (tile != _tiles.end() && tile->second.type() != type){
+        tile->second.type() = type;
+        _isDirty = true;
+        _wallsValid = false;
+    }
+
+    return;
+}
+
 void Region::destroyTile(Location localLocation){
     if (tileExistsAt(localLocation)){
         _tiles.erase(localLocation);
+        _isDirty = true;
+        _wallsValid = false;
     }
     
     return;
@@ -39,4 +58,24 @@ void Region::destroyTile(Location localLocation){
 
 bool Region::tileExistsAt(Location localLocation){
     return _tiles.count(localLocation) > 0;
+}
+
+const std::vector<uint64_t>& Region::walls(){
+    if (!_wallsValid){
+        int stride = wallStride();
+        _walls.assign(size_t(_size) * size_t(stride), 0);
+
+        // Sets a bit for every wall tile within the bounds of the region.
+        for (auto & tile : _tiles){
+            const Location& location = tile.first;
+
+            if (tile.second.type() == TILE_WALL && location.row() >= 0 && location.column() >= 0 && location.row() < _size && location.column() < _size){
+                _walls[size_t(location.row()) * size_t(stride) + size_t(location.column() / 64)] |= uint64_t(1) << (location.column() % 64);
+            }
+        }
+
+        _wallsValid = true;
+    }
+
+    return _walls;
 }
\ No newline at end of file
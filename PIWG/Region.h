@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include <map>
+#include <vector>
 #include "Tile.h"
 #include "Location.h"
 
@@ -8,22 +10,37 @@
 class Region{
     public:
         Region(int size);
-        Region(std::map<Location, Tile> tiles);
+        Region(std::map<Location, Tile> tiles, int size);
         ~Region(){}
 
-        // Utility functions for directly dealing with tiles.
-        Tile* tileAt(Location localLocation);
-        Tile* createTile(Location localLocation, Tile tile);
+        // Utility functions for directly dealing with tiles. Tiles are only ever
+        // changed through these functions, so the region knows when it's been modified.
+        const Tile* tileAt(Location localLocation);
+        const Tile* createTile(Location localLocation, Tile tile);
+        void setTileType(Location localLocation, TileTypes type);
         void destroyTile(Location localLocation);
         bool tileExistsAt(Location localLocation);
 
+        // Packed bitmap of the wall tiles, one row after another with wallStride words per row.
+        // Rebuilt when needed after any function which changes a tile.
+        const std::vector<uint64_t>& walls();
+        const int wallStride() const{return (_size + 63) / 64;}
+
         // Whether this region has been generated and smoothed via cellular automata.
         // Is set by the smoothRegions function in the World class.
         bool& isComplete(){return _isComplete;}
         const bool isComplete() const{return _isComplete;}
-        std::map<Location, Tile>& tiles(){return _tiles;}
+        // Whether this region has been modified since it was generated or loaded, regions which
+        // aren't dirty are skipped when saving. Is set by any function which changes a tile.
+        bool& isDirty(){return _isDirty;}
+        const bool isDirty() const{return _isDirty;}
         const std::map<Location, Tile>& tiles() const{return _tiles;}
+        const int size() const{return _size;}
     private:
         bool _isComplete;
+        bool _isDirty;
+        int _size;
         std::map<Location, Tile> _tiles;
+        bool _wallsValid;
+        std::vector<uint64_t> _walls;
 };
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include <fstream>
+#include "RegionWriter.h"
+
+RegionWriter::RegionWriter() : _stopping(false){
+    _thread = std::thread(&RegionWriter::run, this);
+    return;
+}
+
+RegionWriter::~RegionWriter(){
+    // Stops the background thread once everything queued has been written.
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+
+    _queued.notify_one();
+    _thread.join();
+    return;
+}
+
+void RegionWriter::write(std::string path, std::map<Location, Tile> tiles){
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending[path] = std::move(tiles); // Coalesces with any older copy still waiting.
+    }
+
+    _queued.notify_one();
+    return;
+}
+
+void RegionWriter::flush(){
+    std::unique_lock<std::mutex> lock(_mutex);
+    _written.wait(lock, [this](){return _pending.empty() && _writing.empty();});
+    return;
+}
+
+void RegionWriter::discard(){
+    std::unique_lock<std::mutex> lock(_mutex);
+    _pending.clear();
+    _written.wait(lock, [this](){return _writing.empty();});
+    return;
+}
+
+bool RegionWriter::find(std::string path, std::map<Location, Tile>& tiles){
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // The pending batch is always newer than the one being written.
+    for (auto * batch : {&_pending, &_writing}){
+        if (batch->find(path) != batch->end()){
+            tiles = batch->find(path)->second;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool RegionWriter::isQueued(std::string path){
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending.count(path) > 0 || _writing.count(path) > 0;
+}
+
+void RegionWriter::run(){
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true){
+        _queued.wait(lock, [this](){return _stopping || !_pending.empty();});
+
+        if (_pending.empty()){
+            break; // Only reached once stopping with nothing left to write.
+        }
+
+        // Takes every queued region as one batch, the batch is only read while unlocked
+        // so that find can still copy out of it until it has been written.
+        _writing.swap(_pending);
+        lock.unlock();
+
+        for (auto & region : _writing){
+            std::ofstream outFile;
+            outFile.open(region.first, std::ostream::trunc);
+
+            // Saves each tile as its location plus its icon.
+            // Format appears as "(row,column) icon ".
+            for (auto & tile : region.second){
+                outFile << std::to_string(tile.first.row()) + " " + std::to_string(tile.first.column()) + " " + std::to_string(tile.second.type()) + " ";
+            }
+
+            outFile.close();
+        }
+
+        lock.lock();
+        _writing.clear();
+        _written.notify_all();
+    }
+
+    return;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Tile.h"
+#include "Location.h"
+
+// Write-behind persistence used by the world class. Regions are queued with the path they
+// belong to and written by a background thread in batches, so disk writes never happen on
+// the calling thread. Queuing the same path again before it is written replaces the older copy.
+class RegionWriter{
+    public:
+        RegionWriter();
+        ~RegionWriter();
+
+        // Queues the tiles of a region to be written to a path.
+        void write(std::string path, std::map<Location, Tile> tiles);
+
+        // Blocks until every queued region has been written.
+        void flush();
+
+        // Drops every region that hasn't started being written and
+        // blocks until the batch currently being written is finished.
+        void discard();
+
+        // Copies the most recent queued tiles for a path, returns false if nothing is queued for it.
+        // Regions must be read through here first, as their file may not be written yet.
+        bool find(std::string path, std::map<Location, Tile>& tiles);
+        bool isQueued(std::string path);
+    private:
+        // Loop ran by the background thread, writes each batch of queued regions.
+        void run();
+
+        std::mutex _mutex;
+        std::condition_variable _queued;
+        std::condition_variable _written;
+        std::map<std::string, std::map<Location, Tile>> _pending; // Regions waiting for the next batch.
+        std::map<std::string, std::map<Location, Tile>> _writing; // The batch currently being written.
+        bool _stopping;
+        std::thread _thread;
+};
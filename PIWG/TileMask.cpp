@@ -0,0 +1,56 @@
+#include "TileMask.h"
+
+TileMask::TileMask(Location center, int radius) : _center(center), _radius(radius < 0 ? 0 : radius){
+    _stride = (size() + 63) / 64;
+    _bits.assign(size_t(size()) * size_t(_stride), 0);
+    return;
+}
+
+bool TileMask::test(Location worldLocation) const{
+    Location local = worldLocation - _center + _radius;
+
+    if (local.row() < 0 || local.column() < 0 || local.row() >= size() || local.column() >= size()){
+        return false;
+    }
+
+    return (_bits[size_t(local.row()) * size_t(_stride) + size_t(local.column() / 64)] >> (local.column() % 64)) & 1;
+}
+
+void TileMask::set(Location worldLocation){
+    Location local = worldLocation - _center + _radius;
+
+    if (local.row() < 0 || local.column() < 0 || local.row() >= size() || local.column() >= size()){
+        return;
+    }
+
+    _bits[size_t(local.row()) * size_t(_stride) + size_t(local.column() / 64)] |= uint64_t(1) << (local.column() % 64);
+    return;
+}
+
+void TileMask::writeBits(int row, int column, uint64_t bits, int count){
+    if (count < 64){
+        bits &= (uint64_t(1) << count) - 1;
+    }
+
+    // A run of bits spans at most two words of the row.
+    uint64_t* words = &_bits[size_t(row) * size_t(_stride)];
+    int shift = column % 64;
+    words[column / 64] |= bits << shift;
+
+    if (shift != 0 && shift + count > 64){
+        words[column / 64 + 1] |= bits >> (64 - shift);
+    }
+
+    return;
+}
+
+uint64_t TileMask::readBits(const uint64_t* words, int offset, int count){
+    int shift = offset % 64;
+    uint64_t bits = words[offset / 64] >> shift;
+
+    if (shift != 0 && shift + count > 64){
+        bits |= words[offset / 64 + 1] << (64 - shift);
+    }
+
+    return count < 64 ? bits & ((uint64_t(1) << count) - 1) : bits;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Location.h"
+
+// Packed bitmap covering a square of world tiles centered on a location, one bit per tile.
+// Used by the world class for visibility queries, both for the walls around a location
+// and for the tiles that were found to be visible from it.
+class TileMask{
+    public:
+        TileMask(Location center = Location(), int radius = 0);
+        ~TileMask(){}
+
+        // Utility functions for directly dealing with bits, locations outside of the mask are never set.
+        bool test(Location worldLocation) const;
+        void set(Location worldLocation);
+
+        // Writes the lowest count bits of a value into a row of the mask, starting at a column.
+        // Both are relative to the top left corner of the mask.
+        void writeBits(int row, int column, uint64_t bits, int count);
+
+        // Reads count bits (at most 64) from an array of words starting at a bit offset.
+        static uint64_t readBits(const uint64_t* words, int offset, int count);
+
+        const Location& center() const{return _center;}
+        const int radius() const{return _radius;}
+        const int size() const{return _radius * 2 + 1;}
+    private:
+        Location _center;
+        int _radius;
+        int _stride; // How many words each row of the mask takes up.
+        std::vector<uint64_t> _bits;
+};
@@ -2,6 +2,8 @@
 #include <fstream>
 #include <string>
 #include <cmath>
+#include <functional>
+#include <algorithm>
 #include "World.h"
 
 World::World(int seed, int regionSize, Location loadDistance) : _regionSize(regionSize), _loadDistance(loadDistance){
@@ -12,6 +14,8 @@ World::World(int seed, int regionSize, Location loadDistance) : _regionSize(regi
 }
 
 World::~World(){
+    // The region files are removed along with the world, so writes still queued are dropped.
+    _writer.discard();
     std::filesystem::remove_all("Data/Regions/");
     return;
 }
@@ -61,10 +65,7 @@ void World::generateRegions(std::set<Location> regionLocations){
 
 void World::smoothRegions(std::set<Location> regionLocations){
     std::set<Location> smoothedRegions;
-    const int cycles{7}; // How many times the algorithm should loop, higher 
-                          // values lead to a longer loading time but a smoother world.
-    
-    for (int c = 0; c < cycles; c++){
+    for (int c = 0; c < Automaton::cycles; c++){
         std::map<Location, Tile> tiles; // A copy of every tile in the world, important so that the
                                         // parameters of the algorithm don't change after it's started.
 
@@ -86,18 +87,14 @@ void World::smoothRegions(std::set<Location> regionLocations){
                 int wallCount = numSurroundingWalls(tile.first);
 
                 // Each tile switches type based on its surroundings.
-                if (tileAt(tile.first)->type() == TILE_GROUND && wallCount >= 5){
-                    tiles[tile.first].type() = TILE_WALL;
-                } else if (tileAt(tile.first)->type() == TILE_WALL && wallCount < 4){
-                    tiles[tile.first].type() = TILE_GROUND;
-                }
+                tiles[tile.first].type() = Automaton::nextType(tileAt(tile.first)->type(), wallCount);
             }
         }
 
         // Set the actual worlds tiles with their new types.
         for (auto & tile : tiles){
             if (tileExistsAt(tile.first)){
-                tileAt(tile.first)->type() = tile.second.type();
+                setTileType(tile.first, tile.second.type());
             }
         }
     }
@@ -111,16 +108,16 @@ void World::smoothRegions(std::set<Location> regionLocations){
 }
 
 void World::saveRegion(Location regionLocation){
-    std::ofstream outFile;
-    outFile.open(pathToRegion(regionLocation), std::ostream::trunc);
+    Region* region = regionAt(regionLocation);
 
-    // Saves each tile as its location plus its icon.
-    // Format appears as "(row,column) icon ".
-    for (auto & tile : regionAt(regionLocation)->tiles()){
-        outFile << std::to_string(tile.first.row()) + " " + std::to_string(tile.first.column()) + " " + std::to_string(tile.second.type()) + " ";
+    // Regions that match their saved copy don't need to be written again.
+    if (region == nullptr || !region->isDirty()){
+        return;
     }
 
-    outFile.close();
+    // Queues the region to be written in the background.
+    _writer.write(pathToRegion(regionLocation), region->tiles());
+    region->isDirty() = false;
     return;
 }
 
@@ -134,13 +131,21 @@ void World::saveRegions(std::set<Location> regionLocations){
 }
 
 void World::loadRegion(Location regionLocation){
+    // A region which is already loaded is never replaced.
+    if (regionExistsAt(regionLocation)){
+        return;
+    }
+
     std::string path = pathToRegion(regionLocation);
+    std::map<Location, Tile> tiles;
 
-    if (isRegionSaved(regionLocation)){
+    // A region still waiting to be written is loaded from the queue, as its file may be out of date.
+    if (_writer.find(path, tiles)){
+        _regions.emplace(regionLocation, Region(tiles, _regionSize));
+    } else if (isRegionSaved(regionLocation)){
         std::ifstream inFile;
         inFile.open(path);
 
-        std::map<Location, Tile> tiles;
         std::string row, column, type;
 
         // Creates a new region with the tiles found in the associated region file.
@@ -151,7 +156,7 @@ void World::loadRegion(Location regionLocation){
             tiles.emplace(Location(std::stoi(row), std::stoi(column)), Tile(static_cast<TileTypes>(std::stoi(type))));
         }
 
-        _regions.emplace(regionLocation, Region(tiles));
+        _regions.emplace(regionLocation, Region(tiles, _regionSize));
         inFile.close();
     }
 
@@ -183,8 +188,8 @@ void World::unloadRegions(std::set<Location> regionLocations){
 }
 
 bool World::isRegionSaved(Location regionLocation){
-    // Returns true if the path to a region file is valid.
-    return std::filesystem::exists(pathToRegion(regionLocation));
+    // Returns true if the region is queued to be written or the path to a region file is valid.
+    return _writer.isQueued(pathToRegion(regionLocation)) || std::filesystem::exists(pathToRegion(regionLocation));
 }
 
 std::string World::pathToRegion(Location regionLocation){
@@ -261,6 +266,166 @@ int World::numSurroundingWalls(Location worldLocation){
     return count;
 }
 
+Location World::raycast(Location fromWorldLocation, Location toWorldLocation){
+    // Bresenham's line algorithm, stepping one tile at a time towards the target.
+    int rowDistance = abs(toWorldLocation.row() - fromWorldLocation.row());
+    int columnDistance = abs(toWorldLocation.column() - fromWorldLocation.column());
+    int rowStep = fromWorldLocation.row() < toWorldLocation.row() ? 1 : -1;
+    int columnStep = fromWorldLocation.column() < toWorldLocation.column() ? 1 : -1;
+    int error = columnDistance - rowDistance;
+
+    // The region under the ray is only looked up again once the ray crosses into another one.
+    RelativeLocation relativeLocation = worldToLocal(fromWorldLocation);
+    Location regionLocation = relativeLocation.regionLocation();
+    Location localLocation = relativeLocation.localLocation();
+    Region* region = regionAt(regionLocation);
+    Location current = fromWorldLocation;
+
+    while (!(current == toWorldLocation)){
+        Location step;
+        int doubledError = error * 2;
+
+        if (doubledError > -rowDistance){
+            error -= rowDistance;
+            step.column() = columnStep;
+        }
+        if (doubledError < columnDistance){
+            error += columnDistance;
+            step.row() = rowStep;
+        }
+
+        current = current + step;
+        localLocation = localLocation + step;
+
+        if (current == toWorldLocation){
+            break;
+        }
+
+        if (localLocation.row() < 0 || localLocation.column() < 0 || localLocation.row() >= _regionSize || localLocation.column() >= _regionSize){
+            relativeLocation = worldToLocal(current);
+            regionLocation = relativeLocation.regionLocation();
+            localLocation = relativeLocation.localLocation();
+            region = regionAt(regionLocation);
+        }
+
+        // Unloaded regions block the ray the same as walls do.
+        if (region == nullptr){
+            return current;
+        }
+
+        const std::vector<uint64_t>& walls = region->walls();
+        if ((walls[size_t(localLocation.row()) * size_t(region->wallStride()) + size_t(localLocation.column() / 64)] >> (localLocation.column() % 64)) & 1){
+            return current;
+        }
+    }
+
+    return toWorldLocation;
+}
+
+bool World::hasLineOfSight(Location fromWorldLocation, Location toWorldLocation){
+    return raycast(fromWorldLocation, toWorldLocation) == toWorldLocation;
+}
+
+TileMask World::fieldOfView(Location worldLocation, int radius){
+    TileMask walls(worldLocation, radius);
+    TileMask visible(worldLocation, radius);
+    Location corner = worldLocation - walls.radius();
+    Location firstRegion = worldToLocal(corner).regionLocation();
+    Location lastRegion = worldToLocal(corner + (walls.size() - 1)).regionLocation();
+
+    // Copies the walls of every region overlapping the mask a word at a time.
+    for (int i = firstRegion.row(); i <= lastRegion.row(); i++){
+        for (int j = firstRegion.column(); j <= lastRegion.column(); j++){
+            Location regionCorner = Location(i, j) * _regionSize;
+            int top = std::max(regionCorner.row(), corner.row());
+            int bottom = std::min(regionCorner.row() + _regionSize, corner.row() + walls.size());
+            int left = std::max(regionCorner.column(), corner.column());
+            int right = std::min(regionCorner.column() + _regionSize, corner.column() + walls.size());
+            Region* region = regionAt(Location(i, j));
+
+            for (int row = top; row < bottom; row++){
+                for (int column = left; column < right; column += 64){
+                    int count = std::min(right - column, 64);
+                    uint64_t bits = ~uint64_t(0);
+
+                    if (region != nullptr){
+                        const uint64_t* regionRow = &region->walls()[size_t(row - regionCorner.row()) * size_t(region->wallStride())];
+                        bits = TileMask::readBits(regionRow, column - regionCorner.column(), count);
+                    }
+
+                    walls.writeBits(row - corner.row(), column - corner.column(), bits, count);
+                }
+            }
+        }
+    }
+
+    visible.set(worldLocation);
+
+    // Recursive shadowcasting, each octant is scanned row by row outwards from the center while
+    // tracking the slopes that are still lit. The multipliers map an octant onto world rows and columns.
+    const int multipliers[4][8] = {
+        {1, 0, 0, -1, -1, 0, 0, 1},
+        {0, 1, -1, 0, 0, -1, 1, 0},
+        {0, 1, 1, 0, 0, -1, -1, 0},
+        {1, 0, 0, 1, -1, 0, 0, -1}
+    };
+
+    std::function<void(int, double, double, int, int, int, int)> castLight;
+    castLight = [&](int distance, double startSlope, double endSlope, int xx, int xy, int yx, int yy){
+        if (startSlope < endSlope){
+            return;
+        }
+
+        double nextStartSlope = startSlope;
+
+        for (int i = distance; i <= radius; i++){
+            bool blocked{false};
+
+            for (int dx = -i, dy = -i; dx <= 0; dx++){
+                double leftSlope = (dx - 0.5) / (dy + 0.5);
+                double rightSlope = (dx + 0.5) / (dy - 0.5);
+
+                if (startSlope < rightSlope){
+                    continue;
+                } else if (endSlope > leftSlope){
+                    break;
+                }
+
+                Location target = worldLocation + Location(dx * yx + dy * yy, dx * xx + dy * xy);
+
+                if (dx * dx + dy * dy <= radius * radius){
+                    visible.set(target);
+                }
+
+                if (blocked){
+                    // Scanning through a run of walls, wait until the next open tile.
+                    if (walls.test(target)){
+                        nextStartSlope = rightSlope;
+                    } else {
+                        blocked = false;
+                        startSlope = nextStartSlope;
+                    }
+                } else if (walls.test(target) && i < radius){
+                    // A wall starts a shadow, light the part of the next row before it.
+                    blocked = true;
+                    castLight(i + 1, startSlope, leftSlope, xx, xy, yx, yy);
+                    nextStartSlope = rightSlope;
+                }
+            }
+
+            if (blocked){
+                break;
+            }
+        }
+    };
+
+    for (int octant = 0; octant < 8; octant++){
+        castLight(1, 1.0, 0.0, multipliers[0][octant], multipliers[1][octant], multipliers[2][octant], multipliers[3][octant]);
+    }
+
+    return visible;
+}
+
 Location World::localToWorld(RelativeLocation relativeLocation){
     // Converts a local location within a region to a world location.
     return relativeLocation.localLocation() + (relativeLocation.regionLocation() * _regionSize);
@@ -273,11 +438,11 @@ RelativeLocation World::worldToLocal(Location worldLocation){
     return RelativeLocation(regionLocation, localLocation);
 }
 
-Tile* World::tileAt(Location worldLocation){
+const Tile* World::tileAt(Location worldLocation){
     return tileAt(worldToLocal(worldLocation));
 }
 
-Tile* World::tileAt(RelativeLocation relativeLocation){
+const Tile* World::tileAt(RelativeLocation relativeLocation){
     if (tileExistsAt(relativeLocation)){
         return regionAt(relativeLocation.regionLocation())->tileAt(relativeLocation.localLocation());
     }
@@ -285,6 +450,19 @@ Tile* World::tileAt(RelativeLocation relativeLocation){
     return nullptr;
 }
 
+void World::setTileType(Location worldLocation, TileTypes type){
+    setTileType(worldToLocal(worldLocation), type);
+    return;
+}
+
+void World::setTileType(RelativeLocation relativeLocation, TileTypes type){
+    if (tileExistsAt(relativeLocation)){
+        regionAt(relativeLocation.regionLocation())->setTileType(relativeLocation.localLocation(), type);
+    }
+
+    return;
+}
+
 bool World::tileExistsAt(Location worldLocation){
     return tileExistsAt(worldToLocal( worldLocation));
 }
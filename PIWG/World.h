@@ -1,7 +1,10 @@
 #pragma once
 #include <ctime>
 #include <set>
+#include "Automaton.h"
 #include "Region.h"
+#include "RegionWriter.h"
+#include "TileMask.h"
 
 // The game world itself, holds all regions and manages generation and the dynamic loading system.
 class World{
@@ -17,7 +20,8 @@ class World{
         void generateRegions(std::set<Location> regionLocations);
         void smoothRegions(std::set<Location> regionLocations);
 
-        // Functions which apply the dynamic loading system.
+        // Functions which apply the dynamic loading system. Saving only queues
+        // dirty regions, which are then written in the background.
         void saveRegion(Location regionLocation);
         void saveRegions(std::set<Location> regionLocations);
         void loadRegion(Location regionLocation);
@@ -39,14 +43,23 @@ class World{
         int numAdjacentWalls(Location worldLocation);
         int numSurroundingWalls(Location worldLocation);
 
+        // Visibility queries which run on the packed wall bitmaps of each region, tiles
+        // within unloaded regions are treated as walls. A wall blocks sight past itself but is
+        // visible, so a ray cast onto a wall still reaches it.
+        Location raycast(Location fromWorldLocation, Location toWorldLocation);
+        bool hasLineOfSight(Location fromWorldLocation, Location toWorldLocation);
+        TileMask fieldOfView(Location worldLocation, int radius);
+
         // Math-based functions for conversion between location types.
         Location localToWorld(RelativeLocation relativeLocation);
         RelativeLocation worldToLocal(Location worldLocation);
 
         // Utility functions for directly dealing with tiles,
         // calls the Region class equivalent of each function.
-        Tile* tileAt(Location worldLocation);
-        Tile* tileAt(RelativeLocation relativeLocation);
+        const Tile* tileAt(Location worldLocation);
+        const Tile* tileAt(RelativeLocation relativeLocation);
+        void setTileType(Location worldLocation, TileTypes type);
+        void setTileType(RelativeLocation relativeLocation, TileTypes type);
         bool tileExistsAt(Location worldLocation);
         bool tileExistsAt(RelativeLocation relativeLocation);
 
@@ -66,4 +79,5 @@ class World{
         Location _activeRegion;
         Location _loadDistance;
         std::map<Location, Region> _regions;
+        RegionWriter _writer;
 };
\ No newline at end of file